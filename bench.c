@@ -0,0 +1,217 @@
+// Include declaration ----------------------------------------------------
+#include "daemon.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+// ------------------------------------------------------------------------
+
+// Struct declaration -----------------------------------------------------
+typedef struct bench_thread
+{
+    pthread_t thread;
+    double* latencies;          // Seconds per request
+    long completed;
+    long failed;
+} bench_thread;
+// ------------------------------------------------------------------------
+
+// Var declaration --------------------------------------------------------
+static const char* socket_path = DECODER_SOCKET_PATH;
+static const char* png_path = "basn6a08.png";
+static long requests = 1000;
+static int by_fd = 0;
+// ------------------------------------------------------------------------
+
+// Function declaration ---------------------------------------------------
+static double now_seconds(void)
+{
+    struct timespec time_now;
+    clock_gettime(CLOCK_MONOTONIC, &time_now);
+
+    return time_now.tv_sec + time_now.tv_nsec / 1e9;
+}
+
+static int compare_double(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+static void* bench_main(void* arg)
+{
+    bench_thread* state = arg;
+    int sock = decoder_client_connect(socket_path);
+
+    if (sock < 0)
+    {
+        printf("Failed to connect to decoder daemon: %s\n", strerror(errno));
+        state->failed = requests;
+        return NULL;
+    }
+
+    for (long i = 0; i < requests; i++)
+    {
+        decoded_image image;
+        int result;
+        double start = now_seconds();
+
+        if (by_fd)
+        {
+            int png_fd = open(png_path, O_RDONLY);
+            result = png_fd < 0 ? -1 : decoder_client_decode_fd(sock, png_fd, &image);
+
+            if (png_fd >= 0)
+            {
+                close(png_fd);
+            }
+        }
+        else
+        {
+            result = decoder_client_decode_path(sock, png_path, &image);
+        }
+
+        if (result != 0)
+        {
+            state->failed++;
+            continue;
+        }
+
+        // Touch the last pixel so the mapping is really faulted in
+        volatile unsigned char last = image.pixels[image.size - 1];
+        (void)last;
+
+        decoder_client_release(&image);
+
+        state->latencies[state->completed++] = now_seconds() - start;
+    }
+
+    decoder_client_close(sock);
+
+    return NULL;
+}
+// ------------------------------------------------------------------------
+
+// Entry point ------------------------------------------------------------
+int main(int argc, char* args[])
+{
+    long clients = 4;
+    int option;
+
+    while ((option = getopt(argc, args, "s:c:n:f")) != -1)
+    {
+        if (option == 's')
+        {
+            socket_path = optarg;
+        }
+        else if (option == 'c')
+        {
+            clients = strtol(optarg, NULL, 10);
+        }
+        else if (option == 'n')
+        {
+            requests = strtol(optarg, NULL, 10);
+        }
+        else if (option == 'f')
+        {
+            by_fd = 1;
+        }
+        else
+        {
+            printf("Usage: %s [-s socket_path] [-c clients] [-n requests_per_client] [-f] [png_path]\n", args[0]);
+            return -1;
+        }
+    }
+
+    if (optind < argc)
+    {
+        png_path = args[optind];
+    }
+
+    if (clients < 1 || requests < 1)
+    {
+        printf("Clients and requests must be positive\n");
+        return -1;
+    }
+
+    bench_thread* threads = calloc(clients, sizeof(bench_thread));
+    double* latencies = malloc(clients * requests * sizeof(double));
+
+    if (threads == NULL || latencies == NULL)
+    {
+        printf("Failed to allocate benchmark state\n");
+        free(threads);
+        free(latencies);
+        return -1;
+    }
+
+    // Start load generators, one connection each
+    double start = now_seconds();
+    long started = 0;
+
+    for (long i = 0; i < clients; i++)
+    {
+        threads[i].latencies = latencies + i * requests;
+
+        if (pthread_create(&threads[i].thread, NULL, bench_main, &threads[i]) != 0)
+        {
+            printf("Failed to start client %ld\n", i);
+            break;
+        }
+
+        started++;
+    }
+
+    long completed = 0;
+    long failed = 0;
+
+    // Join only the clients that actually started
+    for (long i = 0; i < started; i++)
+    {
+        pthread_join(threads[i].thread, NULL);
+
+        // Compact per-thread latencies for the percentile sort
+        memmove(latencies + completed, threads[i].latencies, threads[i].completed * sizeof(double));
+        completed += threads[i].completed;
+        failed += threads[i].failed;
+    }
+
+    double elapsed = now_seconds() - start;
+
+    if (started < clients)
+    {
+        free(threads);
+        free(latencies);
+        return -1;
+    }
+
+    printf("---------------------------------\n");
+    printf("MODE: %s\n", by_fd ? "fd" : "path");
+    printf("CLIENTS: %ld\n", clients);
+    printf("REQUESTS: %ld ok, %ld failed\n", completed, failed);
+    printf("ELAPSED: %.3f s\n", elapsed);
+
+    if (completed > 0)
+    {
+        qsort(latencies, completed, sizeof(double), compare_double);
+
+        printf("THROUGHPUT: %.0f decodes/s\n", completed / elapsed);
+        printf("LATENCY P50: %.1f us\n", latencies[completed / 2] * 1e6);
+        printf("LATENCY P99: %.1f us\n", latencies[completed * 99 / 100] * 1e6);
+        printf("LATENCY MAX: %.1f us\n", latencies[completed - 1] * 1e6);
+    }
+
+    printf("---------------------------------\n");
+
+    free(threads);
+    free(latencies);
+
+    return failed == 0 ? 0 : -1;
+}
+// ------------------------------------------------------------------------
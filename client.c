@@ -0,0 +1,311 @@
+// Include declaration ----------------------------------------------------
+#include "daemon.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+// ------------------------------------------------------------------------
+
+// Define declaration -----------------------------------------------------
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0              // Daemon ignores SIGPIPE where flag is missing
+#endif
+
+#ifndef MSG_CMSG_CLOEXEC
+#define MSG_CMSG_CLOEXEC 0
+#endif
+// ------------------------------------------------------------------------
+
+// Function declaration ---------------------------------------------------
+int socket_send_fd(int sock, const void* data, size_t size, int fd)
+{
+    const char* bytes = data;
+    size_t sent = 0;
+
+    while (sent < size)
+    {
+        struct iovec iov = { (void*)(bytes + sent), size - sent };
+        struct msghdr msg = {0};
+        char control[CMSG_SPACE(sizeof(int))];
+
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        // Attach fd only to the first piece of the message
+        if (fd >= 0 && sent == 0)
+        {
+            memset(control, 0, sizeof(control));
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+            memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+        }
+
+        ssize_t result = sendmsg(sock, &msg, MSG_NOSIGNAL);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return -1;
+        }
+
+        sent += result;
+    }
+
+    return 0;
+}
+
+int socket_recv_fd(int sock, void* data, size_t size, int* fd)
+{
+    char* bytes = data;
+    size_t received = 0;
+
+    if (fd != NULL)
+    {
+        *fd = -1;
+    }
+
+    while (received < size)
+    {
+        struct iovec iov = { bytes + received, size - received };
+        struct msghdr msg = {0};
+        char control[CMSG_SPACE(sizeof(int))];
+
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t result = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        // Error or peer closed the connection
+        if (result <= 0)
+        {
+            if (result == 0)
+            {
+                errno = ECONNRESET;
+            }
+
+            break;
+        }
+
+        // Keep the first passed fd, close every other one the peer sent
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+            {
+                size_t fd_count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+                for (size_t i = 0; i < fd_count; i++)
+                {
+                    int passed_fd;
+                    memcpy(&passed_fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+
+                    if (fd != NULL && *fd < 0)
+                    {
+                        *fd = passed_fd;
+                    }
+                    else
+                    {
+                        close(passed_fd);
+                    }
+                }
+            }
+        }
+
+        // Control data did not fit: more fds were sent than the protocol allows
+        if (msg.msg_flags & MSG_CTRUNC)
+        {
+            errno = EPROTO;
+            break;
+        }
+
+        received += result;
+    }
+
+    if (received == size)
+    {
+        return 0;
+    }
+
+    int error = errno;
+
+    if (fd != NULL && *fd >= 0)
+    {
+        close(*fd);
+        *fd = -1;
+    }
+
+    errno = error;
+    return -1;
+}
+
+int decoder_client_connect(const char* socket_path)
+{
+    struct sockaddr_un address = {0};
+
+    if (strlen(socket_path) >= sizeof(address.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (sock < 0)
+    {
+        return -1;
+    }
+
+    if (connect(sock, (struct sockaddr*)&address, sizeof(address)) != 0)
+    {
+        int error = errno;
+        close(sock);
+        errno = error;
+        return -1;
+    }
+
+    return sock;
+}
+
+static int receive_image(int sock, decoded_image* image)
+{
+    decode_response response;
+    int pixels_fd;
+
+    image->pixels = NULL;
+    image->fd = -1;
+
+    if (socket_recv_fd(sock, &response, sizeof(response), &pixels_fd) != 0)
+    {
+        return -1;
+    }
+
+    if (response.status != 0 || pixels_fd < 0)
+    {
+        if (pixels_fd >= 0)
+        {
+            close(pixels_fd);
+        }
+
+        // Daemon could not decode the image
+        errno = EIO;
+        return -1;
+    }
+
+    // Map pixels straight from the daemon's shared memory, no copy
+    void* pixels = mmap(NULL, response.size, PROT_READ, MAP_SHARED, pixels_fd, 0);
+
+    if (pixels == MAP_FAILED)
+    {
+        int error = errno;
+        close(pixels_fd);
+        errno = error;
+        return -1;
+    }
+
+    image->pixels = pixels;
+    image->width = response.width;
+    image->height = response.height;
+    image->stride = response.stride;
+    image->size = response.size;
+    image->fd = pixels_fd;
+
+    return 0;
+}
+
+int decoder_client_decode_path(int sock, const char* path, decoded_image* image)
+{
+    if (path[0] == '\0')
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Daemon has its own working directory, send an absolute path
+    char* absolute_path = realpath(path, NULL);
+
+    if (absolute_path == NULL)
+    {
+        return -1;
+    }
+
+    size_t path_length = strlen(absolute_path);
+
+    if (path_length >= DECODER_PATH_MAX)
+    {
+        free(absolute_path);
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    // Send header and path as a single message
+    char message[sizeof(decode_request) + DECODER_PATH_MAX];
+    decode_request request = { DECODE_BY_PATH, (uint32_t)path_length };
+
+    memcpy(message, &request, sizeof(request));
+    memcpy(message + sizeof(request), absolute_path, path_length);
+    free(absolute_path);
+
+    if (socket_send_fd(sock, message, sizeof(request) + path_length, -1) != 0)
+    {
+        return -1;
+    }
+
+    return receive_image(sock, image);
+}
+
+int decoder_client_decode_fd(int sock, int png_fd, decoded_image* image)
+{
+    decode_request request = { DECODE_BY_FD, 0 };
+
+    if (socket_send_fd(sock, &request, sizeof(request), png_fd) != 0)
+    {
+        return -1;
+    }
+
+    return receive_image(sock, image);
+}
+
+void decoder_client_release(decoded_image* image)
+{
+    if (image->pixels != NULL)
+    {
+        munmap((void*)image->pixels, image->size);
+        image->pixels = NULL;
+    }
+
+    if (image->fd >= 0)
+    {
+        close(image->fd);
+        image->fd = -1;
+    }
+}
+
+void decoder_client_close(int sock)
+{
+    if (sock >= 0)
+    {
+        close(sock);
+    }
+}
+// ------------------------------------------------------------------------
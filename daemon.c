@@ -0,0 +1,613 @@
+// Include declaration ----------------------------------------------------
+#define _GNU_SOURCE
+#include "decoder.h"
+#include "daemon.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+// ------------------------------------------------------------------------
+
+// Define declaration -----------------------------------------------------
+#define QUEUE_SIZE 256
+#define MAX_WORKERS 256
+#define MAX_CONNECTIONS 1024
+#define READER_STACK_SIZE (64 << 10)
+// ------------------------------------------------------------------------
+
+// Struct declaration -----------------------------------------------------
+typedef struct decode_job
+{
+    FILE* file;                     // Opened PNG, owned by the connection reader
+    decode_response response;
+    int pixels_fd;                  // Filled by worker, sent back by the reader
+    int done;
+    pthread_mutex_t mutex;
+    pthread_cond_t finished;
+} decode_job;
+// ------------------------------------------------------------------------
+
+// Var declaration --------------------------------------------------------
+static volatile sig_atomic_t quit = 0;
+static int verbose = 0;
+static int connections = 0;
+
+// Decode jobs waiting for a worker, one per request
+static decode_job* queue[QUEUE_SIZE];
+static size_t queue_head = 0;
+static size_t queue_count = 0;
+static pthread_mutex_t queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t queue_not_full = PTHREAD_COND_INITIALIZER;
+// ------------------------------------------------------------------------
+
+// Function declaration ---------------------------------------------------
+static void on_signal(int signal_number)
+{
+    (void)signal_number;
+    quit = 1;
+}
+
+static void queue_push(decode_job* job)
+{
+    pthread_mutex_lock(&queue_mutex);
+
+    while (queue_count == QUEUE_SIZE)
+    {
+        pthread_cond_wait(&queue_not_full, &queue_mutex);
+    }
+
+    queue[(queue_head + queue_count) % QUEUE_SIZE] = job;
+    queue_count++;
+
+    pthread_cond_signal(&queue_not_empty);
+    pthread_mutex_unlock(&queue_mutex);
+}
+
+static decode_job* queue_pop(void)
+{
+    pthread_mutex_lock(&queue_mutex);
+
+    while (queue_count == 0)
+    {
+        pthread_cond_wait(&queue_not_empty, &queue_mutex);
+    }
+
+    decode_job* job = queue[queue_head];
+    queue_head = (queue_head + 1) % QUEUE_SIZE;
+    queue_count--;
+
+    pthread_cond_signal(&queue_not_full);
+    pthread_mutex_unlock(&queue_mutex);
+
+    return job;
+}
+
+static int create_pixels_fd(size_t size)
+{
+    int fd;
+
+#ifdef __linux__
+    // Anonymous memory file, sealed before it is handed to the client
+    fd = memfd_create("decoder_png", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+    // Fallback: named shared memory, unlinked right away
+    char name[64];
+    static volatile uint32_t counter = 0;
+
+    snprintf(name, sizeof(name), "/decoder_png.%ld.%u", (long)getpid(), __sync_fetch_and_add(&counter, 1));
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+    if (fd >= 0)
+    {
+        shm_unlink(name);
+    }
+#endif
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    if (ftruncate(fd, size) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static FILE* open_png_fd(int png_fd, void** file_data)
+{
+    struct stat info;
+    FILE* file = NULL;
+
+    *file_data = NULL;
+
+    // Regular files only, copied with pread from offset 0: a passed fd shares its file offset with the client
+    if (fstat(png_fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 && info.st_size <= MAX_PNG_FILE_SIZE)
+    {
+        size_t size = info.st_size;
+        size_t offset = 0;
+        char* data = malloc(size);
+
+        while (data != NULL && offset < size)
+        {
+            ssize_t result = pread(png_fd, data + offset, size - offset, offset);
+
+            if (result < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (result <= 0)
+            {
+                break;
+            }
+
+            offset += result;
+        }
+
+        if (data != NULL && offset == size)
+        {
+            file = fmemopen(data, size, "rb");
+        }
+
+        if (file == NULL)
+        {
+            free(data);
+        }
+        else
+        {
+            *file_data = data;
+        }
+    }
+
+    close(png_fd);
+
+    return file;
+}
+
+static int decode_to_shared(FILE* file, decode_response* response, int* pixels_fd)
+{
+    IHDRchunk IHDR_data;
+    unsigned long inflated_size;
+
+    *pixels_fd = -1;
+
+    unsigned char* IDAT_data = inflate_png(file, &IHDR_data, &inflated_size, verbose);
+
+    if (IDAT_data == NULL)
+    {
+        return -1;
+    }
+
+    int stride = IHDR_data.width * 4;
+    size_t size = (size_t)IHDR_data.height * stride;
+
+    // Reject unknown filter types up front, get_array_buffer cannot report them
+    for (uint32_t r = 0; r < IHDR_data.height; r++)
+    {
+        if (IDAT_data[(size_t)r * (stride + 1)] > 4)
+        {
+            fprintf(stderr, "Unknown filter type: %d\n", IDAT_data[(size_t)r * (stride + 1)]);
+            free(IDAT_data);
+            return -1;
+        }
+    }
+
+    int fd = create_pixels_fd(size);
+
+    if (fd < 0)
+    {
+        fprintf(stderr, "Failed to create shared memory: %s\n", strerror(errno));
+        free(IDAT_data);
+        return -1;
+    }
+
+    // Reconstruct scanlines directly into the shared region
+    unsigned char* buffer = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (buffer == MAP_FAILED)
+    {
+        fprintf(stderr, "Failed to map shared memory: %s\n", strerror(errno));
+        close(fd);
+        free(IDAT_data);
+        return -1;
+    }
+
+    get_array_buffer(IDAT_data, buffer, IHDR_data.width, IHDR_data.height);
+
+    munmap(buffer, size);
+    free(IDAT_data);
+
+#ifdef __linux__
+    // Client gets an immutable image, never hand out an unsealed one
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0)
+    {
+        fprintf(stderr, "Failed to seal shared memory: %s\n", strerror(errno));
+        close(fd);
+        return -1;
+    }
+#endif
+
+    response->width = IHDR_data.width;
+    response->height = IHDR_data.height;
+    response->stride = stride;
+    response->size = size;
+    *pixels_fd = fd;
+
+    return 0;
+}
+
+static void serve_client(int sock)
+{
+    decode_job job;
+
+    pthread_mutex_init(&job.mutex, NULL);
+    pthread_cond_init(&job.finished, NULL);
+
+    while (1)
+    {
+        decode_request request;
+        int png_fd;
+        FILE* file = NULL;
+        void* file_data = NULL;
+
+        // Wait for next request, stop on disconnect or idle timeout
+        if (socket_recv_fd(sock, &request, sizeof(request), &png_fd) != 0)
+        {
+            break;
+        }
+
+        if (request.kind == DECODE_BY_PATH && png_fd < 0 && request.path_length > 0 && request.path_length < DECODER_PATH_MAX)
+        {
+            char path[DECODER_PATH_MAX];
+
+            if (socket_recv_fd(sock, path, request.path_length, NULL) != 0)
+            {
+                break;
+            }
+
+            path[request.path_length] = '\0';
+
+            // Relative paths would resolve against the daemon's working directory
+            // Non-blocking open so a FIFO cannot stall here, then the same checks as a passed fd
+            if (path[0] == '/')
+            {
+                png_fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+            }
+
+            if (png_fd >= 0)
+            {
+                file = open_png_fd(png_fd, &file_data);
+            }
+        }
+        else if (request.kind == DECODE_BY_FD && png_fd >= 0)
+        {
+            file = open_png_fd(png_fd, &file_data);
+        }
+        else
+        {
+            // Malformed request, stream is out of sync
+            fprintf(stderr, "Invalid decode request\n");
+
+            if (png_fd >= 0)
+            {
+                close(png_fd);
+            }
+
+            break;
+        }
+
+        memset(&job.response, 0, sizeof(job.response));
+        job.response.status = -1;
+        job.pixels_fd = -1;
+
+        if (file != NULL)
+        {
+            // Hand the decode to the pool and wait for this request only
+            job.file = file;
+            job.done = 0;
+            queue_push(&job);
+
+            pthread_mutex_lock(&job.mutex);
+
+            while (!job.done)
+            {
+                pthread_cond_wait(&job.finished, &job.mutex);
+            }
+
+            pthread_mutex_unlock(&job.mutex);
+
+            fclose(file);
+            free(file_data);
+        }
+
+        int result = socket_send_fd(sock, &job.response, sizeof(job.response), job.pixels_fd);
+
+        if (job.pixels_fd >= 0)
+        {
+            close(job.pixels_fd);
+        }
+
+        if (result != 0)
+        {
+            break;
+        }
+    }
+
+    pthread_cond_destroy(&job.finished);
+    pthread_mutex_destroy(&job.mutex);
+}
+
+static void* connection_main(void* arg)
+{
+    int sock = (int)(intptr_t)arg;
+
+    serve_client(sock);
+    close(sock);
+
+    __sync_fetch_and_sub(&connections, 1);
+
+    return NULL;
+}
+
+static void* worker_main(void* arg)
+{
+    (void)arg;
+
+    // Workers only decode, connections are read by their own threads
+    while (1)
+    {
+        decode_job* job = queue_pop();
+
+        job->response.status = decode_to_shared(job->file, &job->response, &job->pixels_fd);
+
+        pthread_mutex_lock(&job->mutex);
+        job->done = 1;
+        pthread_cond_signal(&job->finished);
+        pthread_mutex_unlock(&job->mutex);
+    }
+
+    return NULL;
+}
+
+static int remove_stale_socket(const char* socket_path, const struct sockaddr_un* address)
+{
+    struct stat info;
+
+    if (lstat(socket_path, &info) != 0)
+    {
+        return errno == ENOENT ? 0 : -1;
+    }
+
+    // Never delete something that is not a socket
+    if (!S_ISSOCK(info.st_mode))
+    {
+        fprintf(stderr, "%s exists and is not a socket\n", socket_path);
+        return -1;
+    }
+
+    // Only a socket nobody listens on any more is stale
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (probe < 0)
+    {
+        return -1;
+    }
+
+    int result = connect(probe, (const struct sockaddr*)address, sizeof(*address));
+    int error = errno;
+
+    close(probe);
+
+    if (result == 0)
+    {
+        fprintf(stderr, "%s is in use by a running daemon\n", socket_path);
+        return -1;
+    }
+
+    if (error != ECONNREFUSED)
+    {
+        fprintf(stderr, "Failed to probe %s: %s\n", socket_path, strerror(error));
+        return -1;
+    }
+
+    return unlink(socket_path);
+}
+
+static void unlink_own_socket(const char* socket_path, const struct stat* bound)
+{
+    struct stat info;
+
+    // Leave the path alone if it was replaced after we bound it
+    if (lstat(socket_path, &info) == 0 && info.st_dev == bound->st_dev && info.st_ino == bound->st_ino)
+    {
+        unlink(socket_path);
+    }
+}
+
+static void print_usage(const char* name)
+{
+    fprintf(stderr, "Usage: %s [-s socket_path] [-j workers] [-t idle_seconds] [-v]\n", name);
+}
+// ------------------------------------------------------------------------
+
+// Entry point ------------------------------------------------------------
+int main(int argc, char* args[])
+{
+    const char* socket_path = DECODER_SOCKET_PATH;
+    long workers = sysconf(_SC_NPROCESSORS_ONLN);
+    long idle_seconds = 30;
+    int option;
+
+    while ((option = getopt(argc, args, "s:j:t:v")) != -1)
+    {
+        if (option == 's')
+        {
+            socket_path = optarg;
+        }
+        else if (option == 'j')
+        {
+            workers = strtol(optarg, NULL, 10);
+        }
+        else if (option == 't')
+        {
+            idle_seconds = strtol(optarg, NULL, 10);
+        }
+        else if (option == 'v')
+        {
+            verbose = 1;
+        }
+        else
+        {
+            print_usage(args[0]);
+            return -1;
+        }
+    }
+
+    if (workers < 1)
+    {
+        workers = 1;
+    }
+    else if (workers > MAX_WORKERS)
+    {
+        workers = MAX_WORKERS;
+    }
+
+    if (idle_seconds < 1)
+    {
+        idle_seconds = 1;
+    }
+
+    // Decoder reports errors and -v dump on stdout: flush per line so they show up
+    // when redirected and whole lines from different workers do not interleave
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    struct sockaddr_un address = {0};
+
+    if (strlen(socket_path) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Socket path too long: %s\n", socket_path);
+        return -1;
+    }
+
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    // Init listening socket, replacing a stale one
+    int listen_sock = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listen_sock < 0)
+    {
+        fprintf(stderr, "Failed to create socket: %s\n", strerror(errno));
+        return -1;
+    }
+
+    if (remove_stale_socket(socket_path, &address) != 0)
+    {
+        fprintf(stderr, "Refusing to replace %s\n", socket_path);
+        close(listen_sock);
+        return -1;
+    }
+
+    struct stat bound;
+
+    if (bind(listen_sock, (struct sockaddr*)&address, sizeof(address)) != 0 || lstat(socket_path, &bound) != 0 ||
+        listen(listen_sock, SOMAXCONN) != 0)
+    {
+        fprintf(stderr, "Failed to listen on %s: %s\n", socket_path, strerror(errno));
+        close(listen_sock);
+        return -1;
+    }
+
+    // Signals: clients going away must not kill the daemon, INT/TERM stop accept loop
+    struct sigaction action = {0};
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, NULL);
+
+    action.sa_handler = on_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // Init worker pool
+    for (long i = 0; i < workers; i++)
+    {
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, worker_main, NULL) != 0)
+        {
+            fprintf(stderr, "Failed to start worker %ld\n", i);
+            close(listen_sock);
+            unlink_own_socket(socket_path, &bound);
+            return -1;
+        }
+
+        pthread_detach(thread);
+    }
+
+    // Connection readers mostly sleep in recvmsg, keep their stacks small
+    pthread_attr_t reader_attr;
+    pthread_attr_init(&reader_attr);
+    pthread_attr_setdetachstate(&reader_attr, PTHREAD_CREATE_DETACHED);
+    pthread_attr_setstacksize(&reader_attr, READER_STACK_SIZE < PTHREAD_STACK_MIN ? PTHREAD_STACK_MIN : READER_STACK_SIZE);
+
+    // Idle or stalled clients are dropped after this long
+    struct timeval idle_limit = { idle_seconds, 0 };
+
+    fprintf(stderr, "Decoder daemon listening on %s with %ld workers\n", socket_path, workers);
+
+    // Main loop
+    while (!quit)
+    {
+        int sock = accept(listen_sock, NULL, NULL);
+
+        if (sock < 0)
+        {
+            if (errno != EINTR)
+            {
+                fprintf(stderr, "Failed to accept connection: %s\n", strerror(errno));
+            }
+
+            continue;
+        }
+
+        if (__sync_add_and_fetch(&connections, 1) > MAX_CONNECTIONS)
+        {
+            fprintf(stderr, "Too many connections, dropping client\n");
+            __sync_fetch_and_sub(&connections, 1);
+            close(sock);
+            continue;
+        }
+
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &idle_limit, sizeof(idle_limit));
+        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &idle_limit, sizeof(idle_limit));
+
+        // One lightweight reader per connection, decodes go to the pool
+        pthread_t thread;
+
+        if (pthread_create(&thread, &reader_attr, connection_main, (void*)(intptr_t)sock) != 0)
+        {
+            fprintf(stderr, "Failed to start connection reader\n");
+            __sync_fetch_and_sub(&connections, 1);
+            close(sock);
+        }
+    }
+
+    // Clean up resources
+    pthread_attr_destroy(&reader_attr);
+    close(listen_sock);
+    unlink_own_socket(socket_path, &bound);
+
+    return 0;
+}
+// ------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+// Include declaration ----------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+// ------------------------------------------------------------------------
+
+// Define declaration -----------------------------------------------------
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#define DECODER_SOCKET_PATH "/tmp/decoder_png.sock"
+#define DECODER_PATH_MAX 4096
+
+#define DECODE_BY_PATH 1            // Request followed by absolute path bytes, relative paths are rejected
+#define DECODE_BY_FD 2              // Request carries an open PNG fd (SCM_RIGHTS), read with pread, offset untouched
+// ------------------------------------------------------------------------
+
+// Struct declaration -----------------------------------------------------
+typedef struct decode_request
+{
+    uint32_t kind;                  // DECODE_BY_PATH or DECODE_BY_FD
+    uint32_t path_length;           // Bytes of path that follow, 0 for DECODE_BY_FD
+} decode_request;
+
+typedef struct decode_response
+{
+    int32_t status;                 // 0 ok, pixels fd attached (SCM_RIGHTS); -1 failed
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint64_t size;                  // Bytes of RGBA32 pixels in shared memory
+} decode_response;
+
+typedef struct decoded_image
+{
+    const unsigned char* pixels;    // Read-only mapping of the daemon's memfd
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    size_t size;
+    int fd;
+} decoded_image;
+#endif
+// ------------------------------------------------------------------------
+
+// Function declaration ---------------------------------------------------
+// Client calls never print: they return -1 with errno set (EIO when the daemon failed to decode)
+int socket_send_fd(int sock, const void* data, size_t size, int fd);
+
+int socket_recv_fd(int sock, void* data, size_t size, int* fd);
+
+int decoder_client_connect(const char* socket_path);
+
+// Path is resolved with realpath() in the caller's working directory before sending
+int decoder_client_decode_path(int sock, const char* path, decoded_image* image);
+
+int decoder_client_decode_fd(int sock, int png_fd, decoded_image* image);
+
+void decoder_client_release(decoded_image* image);
+
+void decoder_client_close(int sock);
+// ------------------------------------------------------------------------
@@ -1,5 +1,6 @@
 // Include declaration ----------------------------------------------------
 #include "decoder.h"
+#include <SDL.h>
 // ------------------------------------------------------------------------ 
 
 // Define declaration -----------------------------------------------------
@@ -32,151 +33,19 @@ int main(int argc, char* args[])
         return -1;
     }
 
-    // Read first 8 bytes
-    char header[8];
-
-    if (fread(header, sizeof(char), sizeof(header), file) != sizeof(header))
-    {
-        printf("Failed to read file header\n");
-        fclose(file);
-        SDL_Quit();
-
-        return -1;
-    }
-
-    // PNG signature as a pointer
-    const char* pngSign = "\x89PNG\r\n\x1a\n";
-
-    // Check if the header matches the PNG signature
-    if (memcmp(header, pngSign, 8) == 0) 
-    {
-        printf("File is a PNG with correct signature!\n");
-    } 
-    else 
-    {
-        printf("File is not a PNG or has an incorrect signature.\n");
-        return -1;
-    }
-
-    // Reset file pointer to the beginning of the file
-    //fseek(file, 0, SEEK_SET);
-
-    // Init  chunks
-    chunks *my_chunks;
-    size_t counter_IDAT;
-    size_t counter_CHUNKS;
-
-    // Read chunks from PNG and fill chunks array
+    // Decode signature, chunks, IHDR and IDAT in one pass
+    IHDRchunk IHDR_data;
+    unsigned long uncompressed_size;
+    unsigned char* IDAT_data = inflate_png(file, &IHDR_data, &uncompressed_size, 1);
 
-    if(get_chunks(file, &my_chunks, &counter_IDAT, &counter_CHUNKS))
-    {
-        printf("Failed to fill chunk array!\n");
-        return -1;
-    }
-    
     // Close the file
     fclose(file);
-    
-    printf("TOTAL PNG CHUNKS: %llu\n",counter_CHUNKS);
-    printf("TOTAL IDAT CHUNKS: %llu\n", counter_IDAT);
-    printf("---------------------------------\n");
-
-    // Init IHDR chunk
-    IHDRchunk IHDR_data;
-
-    // Check if correct chunk
-    if (strcmp(my_chunks[0].chunk_type, "IHDR") == 0)
-    {
-        // Copy from chunk to struct IHDR
-        memcpy(&IHDR_data, my_chunks[0].chunk_data, sizeof(IHDRchunk));
-
-        // Reverse byte
-        IHDR_data.width = reverse_endian(IHDR_data.width);
-        IHDR_data.height = reverse_endian(IHDR_data.height);
-
-        // Print extracted chunk's info
-        printf("CHUNK IHDR ----------------------\n");
-        printf("Width: %u\n", IHDR_data.width);
-        printf("Height: %u\n", IHDR_data.height);
-        printf("Bit Depth: %u\n", IHDR_data.bitd);
-        printf("Color Type: %u\n", IHDR_data.colort);
-        printf("Compression Method: %u\n", IHDR_data.compm);
-        printf("Filter Method: %u\n", IHDR_data.filterm);
-        printf("Interlace Method: %u\n", IHDR_data.interlacem);
-    
-        if (IHDR_data.compm != 0 || IHDR_data.filterm != 0 || IHDR_data.colort != 6 || IHDR_data.bitd != 8 || IHDR_data.interlacem != 0)
-        {
-            printf("PNG format not supported!\n");
-            return -1;
-        }
-    }
-    else
-    {
-        printf("Failed to read IHDR chunk!\n");
-        return -1;
-    }
-  
-    // Collect all IDAT chunks to single buffer
-    size_t concatenated_size;
-    Byte* concatenated_data = concatenate_data(my_chunks, counter_CHUNKS, &concatenated_size);
 
-    printf("---------------------------------\n");
-    printf("IDAT SIZE COMPRESSED: %llu (BYTES)\n", concatenated_size); 
-
-    if (concatenated_data != NULL) 
+    if (IDAT_data == NULL)
     {
-        // Print data
-        printf("IDAT DATA: ");
-
-        for (size_t i = 0; i < 8; ++i) {
-            printf("%02X", concatenated_data[i]);
-        }
-
-        printf("[...]\n");
-    }
-    else
-    {
-        printf("Failed to concatenate IDAT chunks\n");
-
-        // Free unused memory
-        free(my_chunks);
-        free(concatenated_data);
-    }
-
-    // Deflate IDAT
-    unsigned long uncompressed_size = concatenated_size * 100;
-    unsigned char* IDAT_data = malloc(uncompressed_size);
-
-    // Get uncompressed data
-    int result = uncompress(IDAT_data, &uncompressed_size, concatenated_data, concatenated_size);
-    
-    if (result != Z_OK)
-    {
-        printf("Failed to decompress data: error %d\n", result);
-
-        // Free unused memory
-        free(my_chunks); 
-        free(IDAT_data);
-        free(concatenated_data);
-
         return -1;
     }
 
-    // Free unused memory
-    free(concatenated_data);
-
-    printf("---------------------------------\n");
-    printf("IDAT SIZE DECOMPRESSED: %lu (BYTES)\n", uncompressed_size); 
-
-    // Print first 8 byte info
-    printf("IDAT DATA: ");
-    for (size_t i = 0; i < 8; ++i) 
-    {
-        printf("%02X", IDAT_data[i]);
-    }
-    printf("[...]\n");
-    printf("---------------------------------\n");
-
     // Process image
     printf ("START PROCESS IMAGE\n");
 
@@ -185,31 +54,25 @@ int main(int argc, char* args[])
     int stride = IHDR_data.width * bytesPerPixel;
     buffer = (unsigned char *)malloc(IHDR_data.height * stride * sizeof(unsigned char));
 
-    // Get array buffer from uncompressed data
-    get_array_buffer(IDAT_data, buffer, IHDR_data.width, IHDR_data.height);
-
     if (buffer == NULL)
     {
         printf("Failed to get buffer from IDAT\n");
 
         // Free unused memory
-        free(my_chunks); 
         free(IDAT_data);
-        free(concatenated_data);
-        free(buffer);
 
         return -1;
     }
 
+    // Get array buffer from uncompressed data
+    get_array_buffer(IDAT_data, buffer, IHDR_data.width, IHDR_data.height);
+
     printf("END PROCESS IMAGE\n");
     printf("---------------------------------\n");
 
     // Free unused memory
     free(IDAT_data);
 
-    // Resize my_chunks to keep only IHDR chunks and free unused memory
-    my_chunks = realloc(my_chunks, sizeof(chunks));
-
     // Init SDL system
     if (SDL_Init(SDL_INIT_VIDEO) != 0)
     {
@@ -305,7 +168,6 @@ int main(int argc, char* args[])
     
     // Free unused memory
     free(buffer);
-    free(my_chunks);
 
     // Close window and quit
     SDL_Quit();
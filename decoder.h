@@ -3,14 +3,17 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <zlib.h>
-#include <SDL.h>  
 // ------------------------------------------------------------------------ 
 
 // Struct declaration -----------------------------------------------------
 #ifndef SETSTRUCT_H
 #define SETSTRUCT_H
 
+#define MAX_PNG_FILE_SIZE (256 << 20)   // Largest PNG (and so chunk) accepted
+#define MAX_CHUNK_LENGTH 0x7FFFFFFF     // PNG spec limit, 2^31 - 1
+
 typedef struct chunks
 {
     Byte* chunk_data;           // 8 bytes data pointer
@@ -47,5 +50,9 @@ void get_array_buffer(unsigned char *IDAT_data, unsigned char *buffer, int width
 
 Byte* concatenate_data(chunks* my_chunks, size_t num_chunks, size_t* concatenated_size);
 
-int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *counter_CHUNKS);
+int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *counter_CHUNKS, int verbose);
+
+void free_chunks(chunks* my_chunks, size_t num_chunks);
+
+unsigned char* inflate_png(FILE* file, IHDRchunk* IHDR_data, unsigned long* inflated_size, int verbose);
 // ------------------------------------------------------------------------ 
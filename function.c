@@ -108,16 +108,18 @@ Byte* concatenate_data(chunks* my_chunks, size_t num_chunks, size_t* concatenate
         }
     }
 
-    // Allocate memory
+    if (total_IDAT_size == 0)
+    {
+        printf("No IDAT data found\n");
+        return NULL;
+    }
+
+    // Allocate memory (chunks stay owned by the caller)
     Byte* concatenated_data = (Byte*)malloc(total_IDAT_size);
 
     if (concatenated_data == NULL) 
     {
         printf("Failed to allocate memory for concatenated data\n");
-
-        // Free unused memory
-        free(my_chunks);
-
         return NULL;
     }
 
@@ -139,7 +141,7 @@ Byte* concatenate_data(chunks* my_chunks, size_t num_chunks, size_t* concatenate
     return concatenated_data;
 }
 
-int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *counter_CHUNKS)
+int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *counter_CHUNKS, int verbose)
 {
     // Index of chunks
     size_t index = 0;
@@ -166,6 +168,9 @@ int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *cou
             return -1;
         }
 
+        // No data owned yet, safe to release on early failure
+        (*my_chunks + index)->chunk_data = NULL;
+
         // CHUNK LENGTH ----------------------------------------------------------------------------------------
         // -----------------------------------------------------------------------------------------------------
         if (fread(&((*my_chunks + index)->chunk_length), sizeof(uint32_t), 1, file) != 1) {
@@ -173,15 +178,29 @@ int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *cou
             printf("Failed to read chunk length\n");
 
             // Free unused memory
-            free(*my_chunks);
+            free_chunks(*my_chunks, index + 1);
 
             return -1;
         }
 
         (*my_chunks + index)->chunk_length = reverse_endian((*my_chunks + index)->chunk_length);
 
-        printf("---------------------------------\n");
-        printf("CHUNK LENGTH: %u\n", (*my_chunks + index)->chunk_length);
+        // Bound the allocation below before trusting the length
+        if ((*my_chunks + index)->chunk_length > MAX_CHUNK_LENGTH || (*my_chunks + index)->chunk_length > MAX_PNG_FILE_SIZE)
+        {
+            printf("Chunk length too large: %u\n", (*my_chunks + index)->chunk_length);
+
+            // Free unused memory
+            free_chunks(*my_chunks, index + 1);
+
+            return -1;
+        }
+
+        if (verbose)
+        {
+            printf("---------------------------------\n");
+            printf("CHUNK LENGTH: %u\n", (*my_chunks + index)->chunk_length);
+        }
         // -----------------------------------------------------------------------------------------------------
         // -----------------------------------------------------------------------------------------------------
 
@@ -192,7 +211,7 @@ int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *cou
             printf("Failed to read chunk type\n");
 
             // Free unused memory
-            free(*my_chunks);
+            free_chunks(*my_chunks, index + 1);
 
             return -1;
         }
@@ -200,7 +219,10 @@ int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *cou
         // Adjust the size based on the expected length of the uint32_t
         (*my_chunks + index)->chunk_type[4] = '\0';
 
-        printf("CHUNK TYPE: %s\n", (*my_chunks + index)->chunk_type);
+        if (verbose)
+        {
+            printf("CHUNK TYPE: %s\n", (*my_chunks + index)->chunk_type);
+        }
         // -----------------------------------------------------------------------------------------------------
         // -----------------------------------------------------------------------------------------------------
 
@@ -213,7 +235,7 @@ int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *cou
             printf("Failed to allocate memory for chunk data\n");
 
             // Free unused memory
-            free(*my_chunks);
+            free_chunks(*my_chunks, index + 1);
 
             return -1;
         }
@@ -224,17 +246,20 @@ int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *cou
             printf("Failed to read chunk data\n");
 
             // Free unused memory
-            free(*my_chunks);
+            free_chunks(*my_chunks, index + 1);
 
             return -1;
         }
 
-        // Get size
-        Byte *start_ptr = (*my_chunks + index)->chunk_data;
-        Byte *end_ptr = start_ptr + (*my_chunks + index)->chunk_length;
-        size_t size_in_bytes = end_ptr - start_ptr;
+        if (verbose)
+        {
+            // Get size
+            Byte *start_ptr = (*my_chunks + index)->chunk_data;
+            Byte *end_ptr = start_ptr + (*my_chunks + index)->chunk_length;
+            size_t size_in_bytes = end_ptr - start_ptr;
 
-        printf("CHUNK DATA: %zu\n", size_in_bytes);
+            printf("CHUNK DATA: %zu\n", size_in_bytes);
+        }
 
         // -----------------------------------------------------------------------------------------------------
         // -----------------------------------------------------------------------------------------------------
@@ -251,21 +276,24 @@ int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *cou
             printf("Failed to read chunk CRC\n");
 
             // Free unused memory
-            free(*my_chunks);
+            free_chunks(*my_chunks, index + 1);
 
             return -1;
         }
 
         (*my_chunks + index)->chunk_crc = reverse_endian((*my_chunks + index)->chunk_crc);
 
-        printf("CHUNCK CRC: %02X\n", (*my_chunks + index)->chunk_crc);
+        if (verbose)
+        {
+            printf("CHUNCK CRC: %02X\n", (*my_chunks + index)->chunk_crc);
+        }
 
         if ((*my_chunks + index)->chunk_crc != checksum)
         {
             printf("Chunk checksum failed: %u != %u\n", (*my_chunks + index)->chunk_crc, checksum);
 
             // Free unused memory
-            free(*my_chunks);
+            free_chunks(*my_chunks, index + 1);
 
             return -1;
         }
@@ -277,7 +305,11 @@ int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *cou
 
         if (strcmp((*my_chunks + index)->chunk_type, "IEND") == 0)
         {
-            printf("---------------------------------\n");
+            if (verbose)
+            {
+                printf("---------------------------------\n");
+            }
+
             return 0;
         }
 
@@ -290,7 +322,160 @@ int get_chunks(FILE* file, chunks **my_chunks, size_t *counter_IDAT, size_t *cou
         // Update counter to next chunk
         index++;
     }
+}
+
+void free_chunks(chunks* my_chunks, size_t num_chunks)
+{
+    if (my_chunks == NULL)
+    {
+        return;
+    }
+
+    // Free data of every chunk, then the array itself
+    for (size_t i = 0; i < num_chunks; ++i)
+    {
+        free(my_chunks[i].chunk_data);
+    }
+
+    free(my_chunks);
+}
+
+unsigned char* inflate_png(FILE* file, IHDRchunk* IHDR_data, unsigned long* inflated_size, int verbose)
+{
+    // Read and check PNG signature
+    char header[8];
+
+    if (fread(header, sizeof(char), sizeof(header), file) != sizeof(header) ||
+        memcmp(header, "\x89PNG\r\n\x1a\n", 8) != 0)
+    {
+        printf("File is not a PNG or has an incorrect signature.\n");
+        return NULL;
+    }
+
+    if (verbose)
+    {
+        printf("File is a PNG with correct signature!\n");
+    }
+
+    // Read chunks from PNG and fill chunks array
+    chunks *my_chunks;
+    size_t counter_IDAT;
+    size_t counter_CHUNKS;
+
+    if (get_chunks(file, &my_chunks, &counter_IDAT, &counter_CHUNKS, verbose))
+    {
+        printf("Failed to fill chunk array!\n");
+        return NULL;
+    }
+
+    if (verbose)
+    {
+        printf("TOTAL PNG CHUNKS: %zu\n", counter_CHUNKS);
+        printf("TOTAL IDAT CHUNKS: %zu\n", counter_IDAT);
+        printf("---------------------------------\n");
+    }
+
+    // IHDR payload is 13 bytes, struct has trailing padding
+    if (strcmp(my_chunks[0].chunk_type, "IHDR") != 0 || my_chunks[0].chunk_length != 13)
+    {
+        printf("Failed to read IHDR chunk!\n");
+        free_chunks(my_chunks, counter_CHUNKS);
+        return NULL;
+    }
+
+    memcpy(IHDR_data, my_chunks[0].chunk_data, 13);
+
+    // Reverse byte
+    IHDR_data->width = reverse_endian(IHDR_data->width);
+    IHDR_data->height = reverse_endian(IHDR_data->height);
+
+    if (verbose)
+    {
+        // Print extracted chunk's info
+        printf("CHUNK IHDR ----------------------\n");
+        printf("Width: %u\n", IHDR_data->width);
+        printf("Height: %u\n", IHDR_data->height);
+        printf("Bit Depth: %u\n", IHDR_data->bitd);
+        printf("Color Type: %u\n", IHDR_data->colort);
+        printf("Compression Method: %u\n", IHDR_data->compm);
+        printf("Filter Method: %u\n", IHDR_data->filterm);
+        printf("Interlace Method: %u\n", IHDR_data->interlacem);
+    }
+
+    if (IHDR_data->compm != 0 || IHDR_data->filterm != 0 || IHDR_data->colort != 6 || IHDR_data->bitd != 8 || IHDR_data->interlacem != 0 ||
+        IHDR_data->width == 0 || IHDR_data->height == 0 || (uint64_t)IHDR_data->width * IHDR_data->height * 4 > INT32_MAX)
+    {
+        printf("PNG format not supported!\n");
+        free_chunks(my_chunks, counter_CHUNKS);
+        return NULL;
+    }
+
+    // Collect all IDAT chunks to single buffer
+    size_t concatenated_size;
+    Byte* concatenated_data = concatenate_data(my_chunks, counter_CHUNKS, &concatenated_size);
+
+    free_chunks(my_chunks, counter_CHUNKS);
+
+    if (concatenated_data == NULL)
+    {
+        printf("Failed to concatenate IDAT chunks\n");
+        return NULL;
+    }
+
+    if (verbose)
+    {
+        printf("---------------------------------\n");
+        printf("IDAT SIZE COMPRESSED: %zu (BYTES)\n", concatenated_size);
+        printf("IDAT DATA: ");
+
+        for (size_t i = 0; i < 8 && i < concatenated_size; ++i)
+        {
+            printf("%02X", concatenated_data[i]);
+        }
+
+        printf("[...]\n");
+    }
+
+    // Exact size of filtered scanlines: one filter byte + stride per row
+    unsigned long expected_size = (unsigned long)IHDR_data->height * (IHDR_data->width * 4 + 1);
+
+    unsigned char* IDAT_data = malloc(expected_size);
+
+    if (IDAT_data == NULL)
+    {
+        printf("Failed to allocate memory for IDAT data\n");
+        free(concatenated_data);
+        return NULL;
+    }
+
+    // Get uncompressed data
+    *inflated_size = expected_size;
+    int result = uncompress(IDAT_data, inflated_size, concatenated_data, concatenated_size);
+
+    free(concatenated_data);
+
+    if (result != Z_OK || *inflated_size != expected_size)
+    {
+        printf("Failed to decompress data: error %d\n", result);
+        free(IDAT_data);
+        return NULL;
+    }
+
+    if (verbose)
+    {
+        printf("---------------------------------\n");
+        printf("IDAT SIZE DECOMPRESSED: %lu (BYTES)\n", *inflated_size);
+        printf("IDAT DATA: ");
+
+        for (size_t i = 0; i < 8 && i < *inflated_size; ++i)
+        {
+            printf("%02X", IDAT_data[i]);
+        }
+
+        printf("[...]\n");
+        printf("---------------------------------\n");
+    }
 
-    printf("---------------------------------\n");
+    return IDAT_data;
 }
 // ------------------------------------------------------------------------ 
\ No newline at end of file